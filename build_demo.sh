@@ -8,7 +8,7 @@ clang++ -g3 -O0 -std=c++17 -c \
     -Isrc/ext/raylib/src \
     src/demo/unity.cpp \
     -o bin/demo.o
-clang++ -g3 -O0 -std=c++17 -c \
+clang++ -g3 -O0 -std=c++17 -DALPSPLINE_STATS -c \
     -Isrc/alpspline/include \
     src/alpspline/src/alpspline.cpp \
     -o bin/alpspline.o
@@ -1,15 +1,23 @@
 set -e
 
-clang++ -g3 -O0 -std=c++17 -c \
-    -Isrc/alpspline/include \
-    src/alpspline/src/alpspline.cpp \
-    -o bin/alpspline.o
-clang++ -g3 -O0 -std=c++17 -c \
-    -Isrc/alpspline/include \
-    src/test/test.cpp \
-    -o bin/test.o
-clang++ \
-    bin/alpspline.o \
-    bin/test.o \
-    -o bin/test
-bin/test
+# Tests run twice, with stats compiled away (default) and with ALPSPLINE_STATS.
+for variant in "" "_stats"; do
+    flags=""
+    if [ "$variant" = "_stats" ]; then
+        flags="-DALPSPLINE_STATS"
+    fi
+    clang++ -g3 -O0 -std=c++17 $flags -c \
+        -Isrc/alpspline/include \
+        src/alpspline/src/alpspline.cpp \
+        -o bin/alpspline$variant.o
+    clang++ -g3 -O0 -std=c++17 $flags -c \
+        -Isrc/alpspline/include \
+        src/test/test.cpp \
+        -o bin/test$variant.o
+    clang++ \
+        bin/alpspline$variant.o \
+        bin/test$variant.o \
+        -lpthread \
+        -o bin/test$variant
+    bin/test$variant
+done
@@ -6,6 +6,7 @@ using ReallocFn = void*(void*, size_t);
 using FreeFn = void(void*);
 
 using u32 = uint32_t;
+using u64 = uint64_t;
 using f32 = float;
 using f64 = double;
 
@@ -32,17 +33,95 @@ void ChangeNumberOfSplinePoints(CubicSpline* spline, u32 newNPoints,
                                 ReallocFn reallocFn = realloc);
 Point3D Interpolate(CubicSpline* spline, f64 param);
 
+struct AABB {
+    Point3D min;
+    Point3D max;
+};
+
+// Plane is n.p + d = 0, points with n.p + d >= 0 are inside.
+struct Plane {
+    Vector3D normal;
+    f64 d;
+};
+
+struct Frustum {
+    Plane planes[6];
+};
+
+struct ArcLengthInterval {
+    f64 start;
+    f64 end;
+};
+
+// Flat BVH node, stored in depth-first order. Left child is always the next node,
+// rightChild is 0 for leaves (a leaf holds exactly one sub-spline).
+struct BVHNode {
+    AABB bounds;
+    u32 firstSubSpline;
+    u32 nSubSplines;
+    u32 rightChild;
+};
+
 struct ALPSpline {
     SplinePoint* points;
     f64 subSplineLength;
     u32 nPoints;
+
+    // Only present if bounds were requested in CreateALPSpline, nullptr otherwise.
+    AABB* subSplineBounds; // nPoints - 1 entries.
+    BVHNode* bvhNodes;
+    u32 nBVHNodes;
 };
 
-ALPSpline CreateALPSpline(CubicSpline* sourceSpline, u32 nSubSplines = 100, MallocFn mallocFn = malloc);
+ALPSpline CreateALPSpline(CubicSpline* sourceSpline, u32 nSubSplines = 100, MallocFn mallocFn = malloc,
+                          bool computeBounds = false);
 void DestroyALPSpline(ALPSpline* spline, FreeFn freeFn = free);
 Point3D InterpolateByParam(ALPSpline* spline, f64 param);
 Point3D InterpolateByArcLength(ALPSpline* spline, f64 arcLength);
 
+struct ALPSplineLevel {
+    ALPSpline spline;
+    f64 maxError; // Estimated max distance from the source spline.
+};
+
+// Chain of ALP splines of the same source spline, each level having half the sub-splines
+// of the previous one. Levels share a single allocation - don't call DestroyALPSpline on them.
+struct ALPSplineLOD {
+    ALPSplineLevel* levels; // levels[0] is the finest.
+    u32 nLevels;
+};
+
+ALPSplineLOD CreateALPSplineLOD(CubicSpline* sourceSpline, u32 nSubSplines = 100, u32 maxLevels = 8,
+                                MallocFn mallocFn = malloc);
+void DestroyALPSplineLOD(ALPSplineLOD* lod, FreeFn freeFn = free);
+// Coarsest level with estimated error within maxError, finest level if none is.
+ALPSpline* SelectLODByError(ALPSplineLOD* lod, f64 maxError);
+ALPSpline* SelectLODByScreenSize(ALPSplineLOD* lod, f64 pixelsPerUnit, f64 maxPixelError = 1.0);
+
+// Both queries require the spline to be created with computeBounds. Arc-length intervals of
+// overlapping sub-splines are written in increasing order, adjacent ones are merged.
+// Returns total number of overlapping intervals, which can be more than maxIntervals - in that
+// case only the first maxIntervals are written and the query should be repeated with a bigger buffer.
+u32 QueryBox(ALPSpline* spline, AABB box, ArcLengthInterval* outIntervals, u32 maxIntervals);
+u32 QueryFrustum(ALPSpline* spline, Frustum* frustum, ArcLengthInterval* outIntervals, u32 maxIntervals);
+
+// Only collected when the library is compiled with ALPSPLINE_STATS defined, zero otherwise.
+// Each thread counts into its own counters, GetALPSplineStats sums them over all threads.
+// ResetALPSplineStats only moves the baseline reported values are relative to, so both can be
+// called from any thread while others keep using the library.
+struct ALPSplineStats {
+    f64 integrationMs;      // MapParamsToArcLength.
+    f64 resamplingMs;       // Creating ALP spline points from the arc length table.
+    u64 samplesIntegrated;
+    u64 bytesAllocated;     // Including growth in ChangeNumberOfSplinePoints, frees are not subtracted.
+    u64 evaluationCalls;    // InterpolateByParam and InterpolateByArcLength.
+    u64 arcLengthClamps;    // Out of range arcLength passed to InterpolateByArcLength.
+    f64 maxArcLengthError;  // Max estimated distance of created ALP splines from their source.
+};
+
+ALPSplineStats GetALPSplineStats();
+void ResetALPSplineStats();
+
 // PRIVATE, move to .cpp after testing.
 struct ParamToArcLengthTable {
     f64 stepSize;
@@ -5,6 +5,155 @@
 #include <stdio.h>
 #include <string.h>
 
+// --------- Stats --------
+
+#ifdef ALPSPLINE_STATS
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#define ALPSPLINE_STAT(...) __VA_ARGS__
+
+// Counters are only written by the owning thread, but read by any thread aggregating them.
+// Reset never writes them, it snapshots them into baseline instead, which is subtracted on read.
+struct ThreadStats {
+    std::atomic<u64> integrationNs;
+    std::atomic<u64> resamplingNs;
+    std::atomic<u64> samplesIntegrated;
+    std::atomic<u64> bytesAllocated;
+    std::atomic<u64> evaluationCalls;
+    std::atomic<u64> arcLengthClamps;
+    std::atomic<f64> maxArcLengthError;
+    // Reset generation in which maxArcLengthError was last written, older values don't count.
+    std::atomic<u64> maxArcLengthErrorGeneration;
+
+    // Guarded by statsMutex.
+    ALPSplineStats baseline;
+    ThreadStats* next;
+
+    ThreadStats();
+    ~ThreadStats();
+};
+
+static std::mutex statsMutex;
+static ThreadStats* statsThreads = nullptr;
+// Stats of threads that already exited.
+static ALPSplineStats statsRetired = {};
+static std::atomic<u64> statsGeneration(0);
+
+// Raw counter values, without the baseline subtracted.
+static ALPSplineStats LoadThreadCounters(ThreadStats* ts) {
+    ALPSplineStats stats;
+    stats.integrationMs = ts->integrationNs.load(std::memory_order_relaxed) * 1e-6;
+    stats.resamplingMs = ts->resamplingNs.load(std::memory_order_relaxed) * 1e-6;
+    stats.samplesIntegrated = ts->samplesIntegrated.load(std::memory_order_relaxed);
+    stats.bytesAllocated = ts->bytesAllocated.load(std::memory_order_relaxed);
+    stats.evaluationCalls = ts->evaluationCalls.load(std::memory_order_relaxed);
+    stats.arcLengthClamps = ts->arcLengthClamps.load(std::memory_order_relaxed);
+    stats.maxArcLengthError = 0.0;
+    if (ts->maxArcLengthErrorGeneration.load(std::memory_order_relaxed) ==
+        statsGeneration.load(std::memory_order_relaxed)) {
+        stats.maxArcLengthError = ts->maxArcLengthError.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+// Counter values since the last reset. Requires statsMutex.
+static ALPSplineStats LoadThreadStats(ThreadStats* ts) {
+    ALPSplineStats stats = LoadThreadCounters(ts);
+    stats.integrationMs -= ts->baseline.integrationMs;
+    stats.resamplingMs -= ts->baseline.resamplingMs;
+    stats.samplesIntegrated -= ts->baseline.samplesIntegrated;
+    stats.bytesAllocated -= ts->baseline.bytesAllocated;
+    stats.evaluationCalls -= ts->baseline.evaluationCalls;
+    stats.arcLengthClamps -= ts->baseline.arcLengthClamps;
+    return stats;
+}
+
+static void AccumulateStats(ALPSplineStats* total, ALPSplineStats stats) {
+    total->integrationMs += stats.integrationMs;
+    total->resamplingMs += stats.resamplingMs;
+    total->samplesIntegrated += stats.samplesIntegrated;
+    total->bytesAllocated += stats.bytesAllocated;
+    total->evaluationCalls += stats.evaluationCalls;
+    total->arcLengthClamps += stats.arcLengthClamps;
+    total->maxArcLengthError = fmax(total->maxArcLengthError, stats.maxArcLengthError);
+}
+
+ThreadStats::ThreadStats()
+    : integrationNs(0), resamplingNs(0), samplesIntegrated(0), bytesAllocated(0),
+      evaluationCalls(0), arcLengthClamps(0), maxArcLengthError(0.0),
+      maxArcLengthErrorGeneration(0), baseline() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    next = statsThreads;
+    statsThreads = this;
+}
+
+ThreadStats::~ThreadStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    AccumulateStats(&statsRetired, LoadThreadStats(this));
+    ThreadStats** link = &statsThreads;
+    while (*link != this) link = &(*link)->next;
+    *link = next;
+}
+
+static ThreadStats* LocalStats() {
+    thread_local ThreadStats stats;
+    return &stats;
+}
+
+// Single writer, so a plain load and store is enough and cheaper than fetch_add.
+static void StatAdd(std::atomic<u64>* counter, u64 value) {
+    counter->store(counter->load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static void StatMaxArcLengthError(ThreadStats* stats, f64 value) {
+    u64 generation = statsGeneration.load(std::memory_order_relaxed);
+    if (stats->maxArcLengthErrorGeneration.load(std::memory_order_relaxed) != generation) {
+        stats->maxArcLengthError.store(value, std::memory_order_relaxed);
+        stats->maxArcLengthErrorGeneration.store(generation, std::memory_order_relaxed);
+    } else if (value > stats->maxArcLengthError.load(std::memory_order_relaxed)) {
+        stats->maxArcLengthError.store(value, std::memory_order_relaxed);
+    }
+}
+
+static u64 StatsNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+ALPSplineStats GetALPSplineStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    ALPSplineStats total = statsRetired;
+    for (ThreadStats* ts = statsThreads; ts; ts = ts->next) {
+        AccumulateStats(&total, LoadThreadStats(ts));
+    }
+    return total;
+}
+
+void ResetALPSplineStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    statsRetired = {};
+    statsGeneration.fetch_add(1, std::memory_order_relaxed);
+    for (ThreadStats* ts = statsThreads; ts; ts = ts->next) {
+        ts->baseline = LoadThreadCounters(ts);
+    }
+}
+
+#else
+
+#define ALPSPLINE_STAT(...)
+
+ALPSplineStats GetALPSplineStats() {
+    return (ALPSplineStats){};
+}
+
+void ResetALPSplineStats() {}
+
+#endif
+
 Point3D InterpolateBetweenPoints(SplinePoint* sp0, SplinePoint* sp1, f64 t) {
     Point3D p0 = sp0->position;
     Vector3D v0 = sp0->velocity;
@@ -49,6 +198,7 @@ static f64 PointArcLength(CubicSpline* spline, f64 param) {
 
 ParamToArcLengthTable MapParamsToArcLength(CubicSpline* spline, f64 stepSize,
                                            MallocFn mallocFn) {
+    ALPSPLINE_STAT(u64 startNs = StatsNowNs());
     ParamToArcLengthTable pToAL = (ParamToArcLengthTable){};
 
     f64 maxT = (f64)(spline->nPoints - 1);
@@ -56,6 +206,7 @@ ParamToArcLengthTable MapParamsToArcLength(CubicSpline* spline, f64 stepSize,
     pToAL.nSteps = nSteps;
     pToAL.stepSize = stepSize;
     pToAL.arcLengths = (f64*)mallocFn(sizeof(f64) * pToAL.nSteps);
+    ALPSPLINE_STAT(StatAdd(&LocalStats()->bytesAllocated, sizeof(f64) * pToAL.nSteps));
 
     f64 t = 0.0;
     f64 arcLength = 0.0;
@@ -90,6 +241,13 @@ ParamToArcLengthTable MapParamsToArcLength(CubicSpline* spline, f64 stepSize,
 
     pToAL.arcLengths[index] = arcLength;
 
+    ALPSPLINE_STAT(
+        ThreadStats* stats = LocalStats();
+        // Three integrand samples per step (left, mid, right).
+        StatAdd(&stats->samplesIntegrated, 3 * (u64)(nSteps - 1));
+        StatAdd(&stats->integrationNs, StatsNowNs() - startNs);
+    )
+
     return pToAL;
 }
 
@@ -127,7 +285,8 @@ bool ArcLengthToParam(ParamToArcLengthTable* palt, f64 arcLength,
             foundIndex += jump;
         }
     }
-    if (foundIndex == nSteps) return false;
+    // Past the end of the table, extrapolate from the last interval instead of reading past it.
+    if (foundIndex >= nSteps - 1) foundIndex = nSteps - 2;
 
     f64 left = arcLengths[foundIndex];
     f64 right = arcLengths[foundIndex + 1];
@@ -144,6 +303,7 @@ bool ArcLengthToParam(ParamToArcLengthTable* palt, f64 arcLength,
 
 CubicSpline CreateCubicSpline(u32 nPoints, MallocFn mallocFn) {
     SplinePoint* points = (SplinePoint*)mallocFn(sizeof(SplinePoint) * nPoints);
+    ALPSPLINE_STAT(StatAdd(&LocalStats()->bytesAllocated, sizeof(SplinePoint) * nPoints));
 
     CubicSpline result;
     result.points = points;
@@ -164,12 +324,16 @@ void ChangeNumberOfSplinePoints(CubicSpline* spline, u32 newNPoints,
     spline->points = (SplinePoint*)reallocFn(
         spline->points, sizeof(SplinePoint) * spline->nPoints);
     if (oldNPoints < newNPoints) {
+        ALPSPLINE_STAT(StatAdd(&LocalStats()->bytesAllocated,
+                               sizeof(SplinePoint) * (newNPoints - oldNPoints)));
         memset(spline->points + oldNPoints, 0, newNPoints - oldNPoints);
     }
 }
 
 Point3D Interpolate(CubicSpline* spline, f64 param) {
     u32 paramFloor = (u32)param;
+    // The end of the spline belongs to the last segment.
+    if (paramFloor >= spline->nPoints - 1) paramFloor = spline->nPoints - 2;
     SplinePoint sp0 = spline->points[paramFloor];
     SplinePoint sp1 = spline->points[paramFloor + 1];
     f64 t = param - paramFloor;
@@ -177,9 +341,221 @@ Point3D Interpolate(CubicSpline* spline, f64 param) {
     return InterpolateBetweenPoints(&sp0, &sp1, t);
 }
 
+// --------- Bounds --------
+
+static void ExpandAABB(AABB* box, Point3D p) {
+    box->min = (Point3D){fmin(box->min.x, p.x), fmin(box->min.y, p.y), fmin(box->min.z, p.z)};
+    box->max = (Point3D){fmax(box->max.x, p.x), fmax(box->max.y, p.y), fmax(box->max.z, p.z)};
+}
+
+static AABB UnionAABB(AABB a, AABB b) {
+    ExpandAABB(&a, b.min);
+    ExpandAABB(&a, b.max);
+    return a;
+}
+
+static bool AABBOverlap(AABB a, AABB b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+static bool AABBInFrustum(AABB box, Frustum* frustum) {
+    for (u32 i = 0; i < 6; ++i) {
+        Plane* plane = &frustum->planes[i];
+        // Corner furthest along the plane normal - if it's outside, the whole box is.
+        f64 x = plane->normal.x >= 0.0 ? box.max.x : box.min.x;
+        f64 y = plane->normal.y >= 0.0 ? box.max.y : box.min.y;
+        f64 z = plane->normal.z >= 0.0 ? box.max.z : box.min.z;
+        if (plane->normal.x * x + plane->normal.y * y + plane->normal.z * z + plane->d < 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Params in (0, 1) where derivative of a single axis of the Hermite segment is zero.
+static u32 HermiteAxisExtrema(f64 p0, f64 v0, f64 p1, f64 v1, f64* outParams) {
+    // Derivative is a*t^2 + b*t + c.
+    f64 a = 6.0 * p0 + 3.0 * v0 - 6.0 * p1 + 3.0 * v1;
+    f64 b = -6.0 * p0 - 4.0 * v0 + 6.0 * p1 - 2.0 * v1;
+    f64 c = v0;
+
+    f64 roots[2];
+    u32 nRoots = 0;
+    if (fabs(a) <= 1e-12 * (fabs(b) + fabs(c))) {
+        if (b != 0.0) roots[nRoots++] = -c / b;
+    } else {
+        f64 discriminant = b * b - 4.0 * a * c;
+        if (discriminant >= 0.0) {
+            f64 sqrtDiscriminant = sqrt(discriminant);
+            roots[nRoots++] = (-b - sqrtDiscriminant) / (2.0 * a);
+            roots[nRoots++] = (-b + sqrtDiscriminant) / (2.0 * a);
+        }
+    }
+
+    u32 nParams = 0;
+    for (u32 i = 0; i < nRoots; ++i) {
+        if (roots[i] > 0.0 && roots[i] < 1.0) outParams[nParams++] = roots[i];
+    }
+    return nParams;
+}
+
+static AABB SubSplineBounds(SplinePoint* sp0, SplinePoint* sp1) {
+    AABB box = {sp0->position, sp0->position};
+    ExpandAABB(&box, sp1->position);
+
+    f64 params[6];
+    u32 nParams = 0;
+    nParams += HermiteAxisExtrema(sp0->position.x, sp0->velocity.x, sp1->position.x,
+                                  sp1->velocity.x, params + nParams);
+    nParams += HermiteAxisExtrema(sp0->position.y, sp0->velocity.y, sp1->position.y,
+                                  sp1->velocity.y, params + nParams);
+    nParams += HermiteAxisExtrema(sp0->position.z, sp0->velocity.z, sp1->position.z,
+                                  sp1->velocity.z, params + nParams);
+    for (u32 i = 0; i < nParams; ++i) {
+        ExpandAABB(&box, InterpolateBetweenPoints(sp0, sp1, params[i]));
+    }
+
+    return box;
+}
+
+static u32 BuildBVHNode(BVHNode* nodes, u32* nNodes, AABB* bounds, u32 first, u32 count) {
+    u32 index = (*nNodes)++;
+    nodes[index].firstSubSpline = first;
+    nodes[index].nSubSplines = count;
+
+    if (count == 1) {
+        nodes[index].bounds = bounds[first];
+        nodes[index].rightChild = 0;
+        return index;
+    }
+
+    // Sub-splines follow each other along the curve, so splitting by index keeps
+    // the children spatially coherent.
+    u32 leftCount = count / 2;
+    u32 leftChild = BuildBVHNode(nodes, nNodes, bounds, first, leftCount);
+    u32 rightChild = BuildBVHNode(nodes, nNodes, bounds, first + leftCount, count - leftCount);
+    nodes[index].bounds = UnionAABB(nodes[leftChild].bounds, nodes[rightChild].bounds);
+    nodes[index].rightChild = rightChild;
+
+    return index;
+}
+
+static void ComputeALPSplineBounds(ALPSpline* spline, MallocFn mallocFn) {
+    u32 nSubSplines = spline->nPoints - 1;
+    spline->subSplineBounds = (AABB*)mallocFn(sizeof(AABB) * nSubSplines);
+    for (u32 i = 0; i < nSubSplines; ++i) {
+        spline->subSplineBounds[i] = SubSplineBounds(&spline->points[i], &spline->points[i + 1]);
+    }
+
+    spline->bvhNodes = (BVHNode*)mallocFn(sizeof(BVHNode) * (2 * nSubSplines - 1));
+    ALPSPLINE_STAT(StatAdd(&LocalStats()->bytesAllocated,
+                           sizeof(AABB) * nSubSplines + sizeof(BVHNode) * (2 * nSubSplines - 1)));
+    spline->nBVHNodes = 0;
+    BuildBVHNode(spline->bvhNodes, &spline->nBVHNodes, spline->subSplineBounds, 0, nSubSplines);
+}
+
+template <typename OverlapFn>
+static u32 QueryBVH(ALPSpline* spline, OverlapFn overlaps, ArcLengthInterval* outIntervals,
+                    u32 maxIntervals) {
+    if (!spline->bvhNodes) return 0;
+
+    u32 nIntervals = 0;
+    u32 lastSubSplineEnd = 0;
+
+    // Depth is logarithmic in the number of sub-splines, 64 is more than enough for u32 counts.
+    u32 stack[64];
+    u32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        BVHNode* node = &spline->bvhNodes[stack[--stackSize]];
+        if (!overlaps(node->bounds)) continue;
+
+        if (node->rightChild != 0) {
+            // Left child visited first, so hits come out in increasing arc-length order.
+            stack[stackSize++] = node->rightChild;
+            stack[stackSize++] = (u32)(node - spline->bvhNodes) + 1;
+            continue;
+        }
+
+        u32 first = node->firstSubSpline;
+        u32 end = first + node->nSubSplines;
+        if (nIntervals > 0 && lastSubSplineEnd == first) {
+            if (nIntervals <= maxIntervals) {
+                outIntervals[nIntervals - 1].end = end * spline->subSplineLength;
+            }
+        } else {
+            // Keep counting once the output is full, so the caller knows how many are missing.
+            if (nIntervals < maxIntervals) {
+                outIntervals[nIntervals] = (ArcLengthInterval){first * spline->subSplineLength,
+                                                               end * spline->subSplineLength};
+            }
+            ++nIntervals;
+        }
+        lastSubSplineEnd = end;
+    }
+
+    return nIntervals;
+}
+
+u32 QueryBox(ALPSpline* spline, AABB box, ArcLengthInterval* outIntervals, u32 maxIntervals) {
+    return QueryBVH(
+        spline, [&](AABB bounds) { return AABBOverlap(bounds, box); }, outIntervals, maxIntervals);
+}
+
+u32 QueryFrustum(ALPSpline* spline, Frustum* frustum, ArcLengthInterval* outIntervals,
+                 u32 maxIntervals) {
+    return QueryBVH(
+        spline, [&](AABB bounds) { return AABBInFrustum(bounds, frustum); }, outIntervals,
+        maxIntervals);
+}
+
 // --------- ALPSpline --------
 
-ALPSpline CreateALPSpline(CubicSpline* sourceSpline, u32 nSubSplines, MallocFn mallocFn) {
+static void FillALPSplinePoints(ALPSpline* alpSpline, CubicSpline* sourceSpline,
+                                ParamToArcLengthTable* palt) {
+    ALPSPLINE_STAT(u64 startNs = StatsNowNs());
+    f64 arcLength = 0.0;
+    f64 param;
+    for(u32 i = 0; i < alpSpline->nPoints; ++i) {
+        ArcLengthToParam(palt, arcLength, &param);
+        alpSpline->points[i].position = Interpolate(sourceSpline, param);
+
+        Vector3D velocity = VelocityAtParam(sourceSpline, param);
+        f64 length = sqrt(velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+        velocity = (Vector3D) {
+            alpSpline->subSplineLength * velocity.x / length, alpSpline->subSplineLength * velocity.y / length, alpSpline->subSplineLength * velocity.z / length
+        };
+        alpSpline->points[i].velocity = velocity;
+
+        arcLength += alpSpline->subSplineLength;
+    }
+    ALPSPLINE_STAT(StatAdd(&LocalStats()->resamplingNs, StatsNowNs() - startNs));
+}
+
+// Max distance between the ALP spline and the source spline, sampled in the middle of each
+// sub-spline where the deviation of a Hermite segment is usually the largest.
+static f64 EstimateALPSplineError(ALPSpline* alpSpline, CubicSpline* sourceSpline,
+                                  ParamToArcLengthTable* palt) {
+    f64 maxError = 0.0;
+    f64 param;
+    for (u32 i = 0; i + 1 < alpSpline->nPoints; ++i) {
+        f64 arcLength = (i + 0.5) * alpSpline->subSplineLength;
+        ArcLengthToParam(palt, arcLength, &param);
+        Point3D expected = Interpolate(sourceSpline, param);
+        Point3D actual = InterpolateBetweenPoints(&alpSpline->points[i], &alpSpline->points[i + 1], 0.5);
+        f64 dx = actual.x - expected.x;
+        f64 dy = actual.y - expected.y;
+        f64 dz = actual.z - expected.z;
+        maxError = fmax(maxError, sqrt(dx * dx + dy * dy + dz * dz));
+    }
+    return maxError;
+}
+
+ALPSpline CreateALPSpline(CubicSpline* sourceSpline, u32 nSubSplines, MallocFn mallocFn,
+                          bool computeBounds) {
     ALPSpline alpSpline = {};
 
     f64 stepSize = 0.001;
@@ -188,23 +564,18 @@ ALPSpline CreateALPSpline(CubicSpline* sourceSpline, u32 nSubSplines, MallocFn m
     f64 sourceSplineLength = palt.arcLengths[palt.nSteps - 1];
 
     alpSpline.subSplineLength = sourceSplineLength / (f64) nSubSplines;
-    alpSpline.nPoints = (u32)(sourceSplineLength / alpSpline.subSplineLength) + 1;
+    alpSpline.nPoints = nSubSplines + 1;
     alpSpline.points = (SplinePoint*)mallocFn(sizeof(SplinePoint) * alpSpline.nPoints);
+    ALPSPLINE_STAT(StatAdd(&LocalStats()->bytesAllocated, sizeof(SplinePoint) * alpSpline.nPoints));
 
-    f64 arcLength = 0.0;
-    f64 param;
-    for(u32 i = 0; i < alpSpline.nPoints; ++i) {
-        ArcLengthToParam(&palt, arcLength, &param);
-        alpSpline.points[i].position = Interpolate(sourceSpline, param);
+    FillALPSplinePoints(&alpSpline, sourceSpline, &palt);
+    ALPSPLINE_STAT(StatMaxArcLengthError(LocalStats(),
+                                         EstimateALPSplineError(&alpSpline, sourceSpline, &palt)));
 
-        Vector3D velocity = VelocityAtParam(sourceSpline, param);
-        f64 length = sqrt(velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
-        velocity = (Vector3D) {
-            alpSpline.subSplineLength * velocity.x / length, alpSpline.subSplineLength * velocity.y / length, alpSpline.subSplineLength * velocity.z / length
-        };
-        alpSpline.points[i].velocity = velocity;
+    DestroyParamToArcLengthTable(&palt);
 
-        arcLength += alpSpline.subSplineLength;
+    if (computeBounds && alpSpline.nPoints > 1) {
+        ComputeALPSplineBounds(&alpSpline, mallocFn);
     }
 
     return alpSpline;
@@ -212,12 +583,81 @@ ALPSpline CreateALPSpline(CubicSpline* sourceSpline, u32 nSubSplines, MallocFn m
 
 void DestroyALPSpline(ALPSpline* spline, FreeFn freeFn) {
     freeFn(spline->points);
+    if (spline->subSplineBounds) freeFn(spline->subSplineBounds);
+    if (spline->bvhNodes) freeFn(spline->bvhNodes);
     *spline = {};
 }
 
+ALPSplineLOD CreateALPSplineLOD(CubicSpline* sourceSpline, u32 nSubSplines, u32 maxLevels,
+                                MallocFn mallocFn) {
+    ALPSplineLOD lod = {};
+
+    u32 nPointsTotal = 0;
+    for (u32 n = nSubSplines; n >= 1 && lod.nLevels < maxLevels; n /= 2) {
+        nPointsTotal += n + 1;
+        ++lod.nLevels;
+    }
+
+    // Levels and all of their points live in one allocation, finest level first.
+    lod.levels = (ALPSplineLevel*)mallocFn(sizeof(ALPSplineLevel) * lod.nLevels +
+                                           sizeof(SplinePoint) * nPointsTotal);
+    SplinePoint* points = (SplinePoint*)(lod.levels + lod.nLevels);
+    ALPSPLINE_STAT(StatAdd(&LocalStats()->bytesAllocated, sizeof(ALPSplineLevel) * lod.nLevels +
+                                                              sizeof(SplinePoint) * nPointsTotal));
+
+    f64 stepSize = 0.001;
+    ParamToArcLengthTable palt = MapParamsToArcLength(sourceSpline, stepSize);
+    f64 sourceSplineLength = palt.arcLengths[palt.nSteps - 1];
+
+    u32 n = nSubSplines;
+    for (u32 i = 0; i < lod.nLevels; ++i) {
+        ALPSpline* spline = &lod.levels[i].spline;
+        *spline = {};
+        spline->subSplineLength = sourceSplineLength / (f64)n;
+        spline->nPoints = n + 1;
+        spline->points = points;
+        FillALPSplinePoints(spline, sourceSpline, &palt);
+        lod.levels[i].maxError = EstimateALPSplineError(spline, sourceSpline, &palt);
+        ALPSPLINE_STAT(StatMaxArcLengthError(LocalStats(), lod.levels[i].maxError));
+
+        points += spline->nPoints;
+        n /= 2;
+    }
+
+    DestroyParamToArcLengthTable(&palt);
+
+    return lod;
+}
+
+void DestroyALPSplineLOD(ALPSplineLOD* lod, FreeFn freeFn) {
+    freeFn(lod->levels);
+    *lod = {};
+}
+
+ALPSpline* SelectLODByError(ALPSplineLOD* lod, f64 maxError) {
+    // Coarser levels have fewer sub-splines, so pick the last one that is still precise enough.
+    u32 selected = 0;
+    for (u32 i = 1; i < lod->nLevels; ++i) {
+        if (lod->levels[i].maxError <= maxError) selected = i;
+    }
+    return &lod->levels[selected].spline;
+}
+
+ALPSpline* SelectLODByScreenSize(ALPSplineLOD* lod, f64 pixelsPerUnit, f64 maxPixelError) {
+    return SelectLODByError(lod, maxPixelError / pixelsPerUnit);
+}
+
 Point3D InterpolateByArcLength(ALPSpline* spline, f64 arcLength) {
-    // todo: arcLength out of range
+    ALPSPLINE_STAT(StatAdd(&LocalStats()->evaluationCalls, 1));
+
+    f64 splineLength = (spline->nPoints - 1) * spline->subSplineLength;
+    if (arcLength < 0.0 || arcLength > splineLength) {
+        ALPSPLINE_STAT(StatAdd(&LocalStats()->arcLengthClamps, 1));
+        arcLength = fmin(fmax(arcLength, 0.0), splineLength);
+    }
+
     u32 firstPointIndex = (u32)(arcLength / spline->subSplineLength);
+    if (firstPointIndex >= spline->nPoints - 1) firstPointIndex = spline->nPoints - 2;
     f32 t = (arcLength - firstPointIndex * spline->subSplineLength) / spline->subSplineLength;
     Point3D result = InterpolateBetweenPoints(&spline->points[firstPointIndex], &spline->points[firstPointIndex + 1], t);
     // printf("arc length point: %.12f, %.12f, %.12f\n", result.x, result.y, result.z);
@@ -225,6 +665,8 @@ Point3D InterpolateByArcLength(ALPSpline* spline, f64 arcLength) {
 }
 
 Point3D InterpolateByParam(ALPSpline* spline, f64 param) {
+    ALPSPLINE_STAT(StatAdd(&LocalStats()->evaluationCalls, 1));
+
     u32 paramFloor = (u32)param;
     SplinePoint sp0 = spline->points[paramFloor];
     SplinePoint sp1 = spline->points[paramFloor + 1];
@@ -7,15 +7,54 @@
 #include "raylib.h"
 #include "raymath.h"
 
-ALPSpline* RecreateALP(ALPSpline* alp, CubicSpline* spline, u32 nALPpoints) {
+struct PerfOverlay {
+    f64 lastBuildMs;
+    u64 lastBuildBytes;
+    f64 evaluationsPerSecond;
+    u64 windowStartEvaluations;
+    f64 windowStartTime;
+};
+
+ALPSpline* RecreateALP(ALPSpline* alp, CubicSpline* spline, u32 nALPpoints, PerfOverlay* perf) {
     if (alp) {
+        DestroyALPSpline(alp);
         free(alp);
     }
+    ALPSplineStats before = GetALPSplineStats();
     alp = (ALPSpline*)malloc(sizeof(ALPSpline));
     *alp = CreateALPSpline(spline, nALPpoints);
+    ALPSplineStats after = GetALPSplineStats();
+    perf->lastBuildMs = (after.integrationMs + after.resamplingMs) -
+                        (before.integrationMs + before.resamplingMs);
+    perf->lastBuildBytes = after.bytesAllocated - before.bytesAllocated;
     return alp;
 }
 
+void UpdatePerfOverlay(PerfOverlay* perf) {
+    f64 now = GetTime();
+    f64 elapsed = now - perf->windowStartTime;
+    if (elapsed >= 0.5) {
+        u64 evaluations = GetALPSplineStats().evaluationCalls;
+        perf->evaluationsPerSecond = (evaluations - perf->windowStartEvaluations) / elapsed;
+        perf->windowStartEvaluations = evaluations;
+        perf->windowStartTime = now;
+    }
+}
+
+void DrawPerfOverlay(PerfOverlay* perf, CubicSpline* spline, ALPSpline* alp, i32 x) {
+    ALPSplineStats stats = GetALPSplineStats();
+    DrawText(TextFormat("Source points: %u, sub-splines: %u", spline->nPoints,
+                        alp ? alp->nPoints - 1 : 0),
+             x, 5, 18, BLACK);
+    DrawText(TextFormat("Last ALP build: %.3f ms, %llu bytes allocated", perf->lastBuildMs,
+                        (unsigned long long)perf->lastBuildBytes),
+             x, 28, 18, BLACK);
+    DrawText(TextFormat("Evaluations: %.0f/s", perf->evaluationsPerSecond), x, 51, 18, BLACK);
+    DrawText(TextFormat("Clamps: %llu, max error: %.4f", (unsigned long long)stats.arcLengthClamps,
+                        stats.maxArcLengthError),
+             x, 74, 18, BLACK);
+}
+
 Vector3D NormalizeVector3D(Vector3D vector) {
     f64 invLength = 1.0f/sqrt(vector.x * vector.x + vector.y * vector.y + vector.z * vector.z);
     return (Vector3D) { vector.x * invLength, vector.y * invLength, vector.z * invLength };
@@ -55,6 +94,7 @@ int main(int argc, char** argv) {
     u32 nALPpoints = 10;
     f64 arcLengthPhase = 0.0;
     bool arcLengthMode = false;
+    PerfOverlay perf = {};
 
     while (!WindowShouldClose()) {
         {
@@ -66,12 +106,12 @@ int main(int argc, char** argv) {
 
                 if (IsKeyPressed(KEY_A)) {
                     nALPpoints += 1;
-                    alp = RecreateALP(alp, &spline, nALPpoints);
+                    alp = RecreateALP(alp, &spline, nALPpoints, &perf);
                 }
 
                 if (IsKeyPressed(KEY_D)) {
                     nALPpoints -= 1;
-                    alp = RecreateALP(alp, &spline, nALPpoints);
+                    alp = RecreateALP(alp, &spline, nALPpoints, &perf);
                 }
             } else {
                 if (IsKeyPressed(KEY_A)) {
@@ -84,14 +124,16 @@ int main(int argc, char** argv) {
                         (SplinePoint){(Point3D){lastPosition.x + lastVelocity.x,
                                                 lastPosition.y + lastVelocity.y, 0},
                                       lastVelocity};
+                    alp = RecreateALP(alp, &spline, nALPpoints, &perf);
                 }
 
                 if (IsKeyPressed(KEY_D) && spline.nPoints > 2) {
                     ChangeNumberOfSplinePoints(&spline, spline.nPoints - 1);
+                    alp = RecreateALP(alp, &spline, nALPpoints, &perf);
                 }
 
                 if (IsKeyPressed(KEY_V)) {
-                    alp = RecreateALP(alp, &spline, nALPpoints);
+                    alp = RecreateALP(alp, &spline, nALPpoints, &perf);
                     arcLengthMode = !arcLengthMode;
                 }
 
@@ -221,11 +263,18 @@ int main(int argc, char** argv) {
                      BLACK);
         }
 
+        UpdatePerfOverlay(&perf);
+        DrawPerfOverlay(&perf, &spline, alp, screenWidth - 420);
+
         EndBlendMode();
         EndMode2D();
         EndDrawing();
     }
 
+    if (alp) {
+        DestroyALPSpline(alp);
+        free(alp);
+    }
     DestroyCubicSpline(&spline);
 
     return 0;
@@ -7,6 +7,10 @@
 
 #include <assert.h>
 
+#ifdef ALPSPLINE_STATS
+#include <thread>
+#endif
+
 constexpr f64 MAX_ERROR = 1e-3;
 
 bool F64Eq(f64 a, f64 b, f64 maxError) {
@@ -171,7 +175,276 @@ void TestParamToArcLength() {
     }
 }
 
+bool PointInAABB(Point3D p, AABB box, f64 maxError) {
+    return p.x >= box.min.x - maxError && p.x <= box.max.x + maxError &&
+           p.y >= box.min.y - maxError && p.y <= box.max.y + maxError &&
+           p.z >= box.min.z - maxError && p.z <= box.max.z + maxError;
+}
+
+bool IntervalsContain(ArcLengthInterval* intervals, u32 nIntervals, f64 arcLength) {
+    for (u32 i = 0; i < nIntervals; ++i) {
+        if (arcLength >= intervals[i].start && arcLength <= intervals[i].end) return true;
+    }
+    return false;
+}
+
+void TestSubSplineBounds() {
+    srand(54321);
+
+    CubicSpline spline = RandomCubicSpline();
+    ALPSpline alp = CreateALPSpline(&spline, 50, malloc, true);
+    u32 nSubSplines = alp.nPoints - 1;
+    assert(alp.subSplineBounds);
+    assert(alp.nBVHNodes == 2 * nSubSplines - 1);
+
+    { // Bounds contain the sub-splines and are tight.
+        for (u32 i = 0; i < nSubSplines; ++i) {
+            AABB box = alp.subSplineBounds[i];
+            Point3D sampledMin = alp.points[i].position;
+            Point3D sampledMax = alp.points[i].position;
+            Point3D end = alp.points[i + 1].position;
+            sampledMin = (Point3D){fmin(sampledMin.x, end.x), fmin(sampledMin.y, end.y), fmin(sampledMin.z, end.z)};
+            sampledMax = (Point3D){fmax(sampledMax.x, end.x), fmax(sampledMax.y, end.y), fmax(sampledMax.z, end.z)};
+            for (f64 t = 0.0; t < 1.0; t += 0.001) {
+                Point3D p = InterpolateByParam(&alp, i + t);
+                assert(PointInAABB(p, box, MAX_ERROR));
+                sampledMin = (Point3D){fmin(sampledMin.x, p.x), fmin(sampledMin.y, p.y), fmin(sampledMin.z, p.z)};
+                sampledMax = (Point3D){fmax(sampledMax.x, p.x), fmax(sampledMax.y, p.y), fmax(sampledMax.z, p.z)};
+            }
+            f64 tightness = 1.0;
+            assert(F64Eq(box.min.x, sampledMin.x, tightness));
+            assert(F64Eq(box.min.y, sampledMin.y, tightness));
+            assert(F64Eq(box.min.z, sampledMin.z, tightness));
+            assert(F64Eq(box.max.x, sampledMax.x, tightness));
+            assert(F64Eq(box.max.y, sampledMax.y, tightness));
+            assert(F64Eq(box.max.z, sampledMax.z, tightness));
+        }
+    }
+
+    ArcLengthInterval intervals[64];
+    f64 alpLength = nSubSplines * alp.subSplineLength;
+
+    { // Root bounds cover the whole spline in a single interval.
+        u32 n = QueryBox(&alp, alp.bvhNodes[0].bounds, intervals, 64);
+        assert(n == 1);
+        assert(F64Eq(intervals[0].start, 0.0, MAX_ERROR));
+        assert(F64Eq(intervals[0].end, alpLength, MAX_ERROR));
+    }
+
+    { // Box far away from the spline.
+        AABB box = {(Point3D){1e7, 1e7, 1e7}, (Point3D){1e7 + 1.0, 1e7 + 1.0, 1e7 + 1.0}};
+        assert(QueryBox(&alp, box, intervals, 64) == 0);
+    }
+
+    { // Small boxes around points on the spline report the arc length of the point.
+        for (f64 arcLength = 0.0; arcLength < alpLength; arcLength += alpLength / 37.0) {
+            Point3D p = InterpolateByArcLength(&alp, arcLength);
+            AABB box = {(Point3D){p.x - 1.0, p.y - 1.0, p.z - 1.0},
+                        (Point3D){p.x + 1.0, p.y + 1.0, p.z + 1.0}};
+            u32 n = QueryBox(&alp, box, intervals, 64);
+            assert(n >= 1);
+            assert(IntervalsContain(intervals, n, arcLength));
+            for (u32 i = 1; i < n; ++i) {
+                assert(intervals[i - 1].end < intervals[i].start);
+            }
+
+            // Frustum made of the box faces gives the same result.
+            Frustum frustum = {{
+                {(Vector3D){1, 0, 0}, -box.min.x}, {(Vector3D){-1, 0, 0}, box.max.x},
+                {(Vector3D){0, 1, 0}, -box.min.y}, {(Vector3D){0, -1, 0}, box.max.y},
+                {(Vector3D){0, 0, 1}, -box.min.z}, {(Vector3D){0, 0, -1}, box.max.z},
+            }};
+            ArcLengthInterval frustumIntervals[64];
+            assert(QueryFrustum(&alp, &frustum, frustumIntervals, 64) == n);
+            for (u32 i = 0; i < n; ++i) {
+                assert(F64Eq(frustumIntervals[i].start, intervals[i].start, MAX_ERROR));
+                assert(F64Eq(frustumIntervals[i].end, intervals[i].end, MAX_ERROR));
+            }
+        }
+    }
+
+    { // Truncated output still reports the total number of intervals.
+        // Box around the middle of the spline in x only, crossed by the spline multiple times.
+        AABB box = alp.bvhNodes[0].bounds;
+        f64 midX = 0.5 * (box.min.x + box.max.x);
+        box.min.x = midX - 1.0;
+        box.max.x = midX + 1.0;
+        u32 total = QueryBox(&alp, box, intervals, 64);
+        assert(total >= 2 && total <= 64);
+        assert(QueryBox(&alp, box, nullptr, 0) == total);
+
+        ArcLengthInterval truncated[1];
+        assert(QueryBox(&alp, box, truncated, 1) == total);
+        assert(F64Eq(truncated[0].start, intervals[0].start, MAX_ERROR));
+        assert(F64Eq(truncated[0].end, intervals[0].end, MAX_ERROR));
+    }
+
+    { // Without bounds queries find nothing.
+        ALPSpline noBounds = CreateALPSpline(&spline, 50);
+        assert(!noBounds.subSplineBounds);
+        assert(QueryBox(&noBounds, alp.bvhNodes[0].bounds, intervals, 64) == 0);
+        DestroyALPSpline(&noBounds);
+    }
+
+    DestroyALPSpline(&alp);
+    DestroyCubicSpline(&spline);
+}
+
+void TestALPSplineLOD() {
+    srand(24680);
+
+    CubicSpline spline = RandomCubicSpline();
+    ALPSplineLOD lod = CreateALPSplineLOD(&spline, 64, 5);
+    assert(lod.nLevels == 5);
+
+    { // Each level matches a separately created ALP spline.
+        u32 nSubSplines = 64;
+        for (u32 i = 0; i < lod.nLevels; ++i) {
+            ALPSpline* level = &lod.levels[i].spline;
+            ALPSpline reference = CreateALPSpline(&spline, nSubSplines);
+            assert(level->nPoints == nSubSplines + 1);
+            assert(level->nPoints == reference.nPoints);
+            assert(F64Eq(level->subSplineLength, reference.subSplineLength, MAX_ERROR));
+            for (u32 j = 0; j < level->nPoints; ++j) {
+                assert(F64Eq(level->points[j].position.x, reference.points[j].position.x, MAX_ERROR));
+                assert(F64Eq(level->points[j].position.y, reference.points[j].position.y, MAX_ERROR));
+                assert(F64Eq(level->points[j].position.z, reference.points[j].position.z, MAX_ERROR));
+            }
+            DestroyALPSpline(&reference);
+            nSubSplines /= 2;
+        }
+    }
+
+    { // Coarser levels are less precise, selection picks the coarsest level within tolerance.
+        for (u32 i = 1; i < lod.nLevels; ++i) {
+            assert(lod.levels[i].maxError > lod.levels[i - 1].maxError);
+        }
+        assert(SelectLODByError(&lod, 0.0) == &lod.levels[0].spline);
+        assert(SelectLODByError(&lod, lod.levels[2].maxError) == &lod.levels[2].spline);
+        assert(SelectLODByError(&lod, 1e30) == &lod.levels[lod.nLevels - 1].spline);
+        assert(SelectLODByScreenSize(&lod, 2.0, 2.0 * lod.levels[1].maxError) ==
+               &lod.levels[1].spline);
+    }
+
+    { // Level count is limited by the number of sub-splines.
+        ALPSplineLOD small = CreateALPSplineLOD(&spline, 5, 8);
+        assert(small.nLevels == 3);
+        assert(small.levels[2].spline.nPoints == 2);
+        DestroyALPSplineLOD(&small);
+    }
+
+    DestroyALPSplineLOD(&lod);
+    DestroyCubicSpline(&spline);
+}
+
+void TestArcLengthOutOfRange() {
+    CubicSpline spline = StraightCubicSpline();
+    ALPSpline alp = CreateALPSpline(&spline, 10);
+    f64 alpLength = (alp.nPoints - 1) * alp.subSplineLength;
+
+    Point3D start = InterpolateByArcLength(&alp, -50.0);
+    assert(F64Eq(start.x, alp.points[0].position.x, MAX_ERROR));
+    Point3D end = InterpolateByArcLength(&alp, alpLength + 50.0);
+    assert(F64Eq(end.x, alp.points[alp.nPoints - 1].position.x, MAX_ERROR));
+    end = InterpolateByArcLength(&alp, alpLength);
+    assert(F64Eq(end.x, alp.points[alp.nPoints - 1].position.x, MAX_ERROR));
+
+    DestroyALPSpline(&alp);
+    DestroyCubicSpline(&spline);
+}
+
+#ifdef ALPSPLINE_STATS
+void TestStats() {
+    ResetALPSplineStats();
+    ALPSplineStats stats = GetALPSplineStats();
+    assert(stats.evaluationCalls == 0 && stats.bytesAllocated == 0);
+
+    CubicSpline spline = StraightCubicSpline();
+    ALPSpline alp = CreateALPSpline(&spline, 10);
+    stats = GetALPSplineStats();
+    assert(stats.samplesIntegrated > 0);
+    assert(stats.bytesAllocated >= sizeof(SplinePoint) * (2 + alp.nPoints));
+    assert(stats.integrationMs > 0.0);
+    assert(stats.resamplingMs > 0.0);
+    assert(stats.maxArcLengthError < MAX_ERROR);
+
+    { // Evaluations on other threads are aggregated, including threads that already exited.
+        auto evaluate = [&alp]() {
+            for (u32 i = 0; i < 100; ++i) InterpolateByParam(&alp, 0.05 * i);
+            InterpolateByArcLength(&alp, -1.0);
+        };
+        std::thread thread0(evaluate);
+        std::thread thread1(evaluate);
+        thread0.join();
+        thread1.join();
+        InterpolateByArcLength(&alp, 1.0);
+
+        stats = GetALPSplineStats();
+        assert(stats.evaluationCalls == 2 * 101 + 1);
+        assert(stats.arcLengthClamps == 2);
+    }
+
+    ResetALPSplineStats();
+    stats = GetALPSplineStats();
+    assert(stats.evaluationCalls == 0 && stats.arcLengthClamps == 0);
+    assert(stats.maxArcLengthError == 0.0);
+
+    { // Growing a cubic spline counts the added points.
+        ChangeNumberOfSplinePoints(&spline, 4);
+        assert(GetALPSplineStats().bytesAllocated == sizeof(SplinePoint) * 2);
+        ChangeNumberOfSplinePoints(&spline, 3);
+        assert(GetALPSplineStats().bytesAllocated == sizeof(SplinePoint) * 2);
+        ChangeNumberOfSplinePoints(&spline, 2);
+        ResetALPSplineStats();
+    }
+
+    { // Counting continues from the reset.
+        srand(13579);
+        CubicSpline curved = RandomCubicSpline();
+        ResetALPSplineStats();
+
+        InterpolateByParam(&alp, 0.5);
+        ALPSpline other = CreateALPSpline(&curved, 5);
+        stats = GetALPSplineStats();
+        assert(stats.evaluationCalls == 1);
+        assert(stats.bytesAllocated == sizeof(SplinePoint) * other.nPoints +
+                                       sizeof(f64) * (stats.samplesIntegrated / 3 + 1));
+        assert(stats.maxArcLengthError > 0.0);
+        DestroyALPSpline(&other);
+        DestroyCubicSpline(&curved);
+    }
+
+    DestroyALPSpline(&alp);
+    DestroyCubicSpline(&spline);
+}
+#else
+void TestStatsDisabled() {
+    CubicSpline spline = StraightCubicSpline();
+    ALPSpline alp = CreateALPSpline(&spline, 10);
+    InterpolateByParam(&alp, 0.5);
+    InterpolateByArcLength(&alp, -1.0);
+
+    ALPSplineStats stats = GetALPSplineStats();
+    assert(stats.integrationMs == 0.0 && stats.resamplingMs == 0.0);
+    assert(stats.samplesIntegrated == 0 && stats.bytesAllocated == 0);
+    assert(stats.evaluationCalls == 0 && stats.arcLengthClamps == 0);
+    assert(stats.maxArcLengthError == 0.0);
+    ResetALPSplineStats();
+
+    DestroyALPSpline(&alp);
+    DestroyCubicSpline(&spline);
+}
+#endif
+
 int main(int argc, char** argv) {
     TestArcLengthIntegrationSimpleSpline(); 
     TestParamToArcLength();
+    TestSubSplineBounds();
+    TestALPSplineLOD();
+    TestArcLengthOutOfRange();
+#ifdef ALPSPLINE_STATS
+    TestStats();
+#else
+    TestStatsDisabled();
+#endif
 }